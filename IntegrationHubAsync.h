@@ -0,0 +1,237 @@
+/**
+ * @file IntegrationHubAsync.h
+ * @brief Non-blocking versions of sendBasket() and sendPayment().
+ *
+ * Requests are handed to a single background sender thread, executed one at
+ * a time in submission order, and their status codes are delivered through a
+ * completion callback.
+ */
+
+#pragma once
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <climits>
+#include "IntegrationHubWrapper.h"
+
+/**
+ * @brief Status passed to a SendCompletionCallback for a request that was
+ * cancelled before it was sent, so the device never saw it.
+ */
+enum {
+    ASYNC_REQUEST_CANCELLED = INT_MIN
+};
+
+/**
+ * @brief Callback function type for completed asynchronous requests.
+ * Called on the background sender thread, never on the submitting thread.
+ * Cancelled requests are reported with ASYNC_REQUEST_CANCELLED on the thread
+ * that cancelled them instead.
+ * Calling waitAsyncRequests() from inside the callback does not wait, because
+ * the sender thread cannot wait for the request it is still completing.
+ * @param requestId The id returned by sendBasketAsync() or sendPaymentAsync().
+ * @param status The status code returned by sendBasket() or sendPayment().
+ */
+typedef void(*SendCompletionCallback)(int, int);
+
+/**
+ * @brief Single-threaded FIFO executor used by the asynchronous send functions.
+ * The worker thread is started on the first submitted request. stop(), which
+ * also runs at program exit, lets the request in progress finish and cancels
+ * the rest.
+ */
+class AsyncSendQueue {
+public:
+    /**
+     * @brief Returns the process-wide queue instance.
+     */
+    static AsyncSendQueue& instance() {
+        static AsyncSendQueue queue;
+        return queue;
+    }
+
+    /**
+     * @brief Appends a request to the queue.
+     * @param ptr A pointer to the ConnectionWrapper object.
+     * @param send The blocking wrapper function that executes the request.
+     * @param jsonData The JSON payload; moved into the queue, not copied.
+     * @param callback The completion callback, or nullptr to discard the result.
+     * @return The id assigned to the request (always greater than zero). Ids
+     *         wrap back to 1 after INT_MAX.
+     */
+    int submit(ConnectionWrapper* ptr, int (*send)(ConnectionWrapper*, std::string),
+               std::string&& jsonData, SendCompletionCallback callback) {
+        std::unique_lock<std::mutex> lock(mutex);
+        lastRequestId = lastRequestId == INT_MAX ? 1 : lastRequestId + 1;
+        int requestId = lastRequestId;
+        if (stopping) {
+            lock.unlock();
+            if (callback != nullptr) {
+                callback(requestId, ASYNC_REQUEST_CANCELLED);
+            }
+            return requestId;
+        }
+        if (!workerRunning) {
+            workerRunning = true;
+            worker = std::thread(&AsyncSendQueue::run, this);
+            workerId = worker.get_id();
+        }
+        requests.emplace_back();
+        Request& request = requests.back();
+        request.requestId = requestId;
+        request.ptr = ptr;
+        request.send = send;
+        request.jsonData = std::move(jsonData);
+        request.callback = callback;
+        lock.unlock();
+        requestCV.notify_one();
+        return requestId;
+    }
+
+    /**
+     * @brief Blocks until every request submitted so far has completed.
+     * Returns immediately when called on the sender thread itself, i.e. from a
+     * completion callback, since waiting there would deadlock.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (workerId == std::this_thread::get_id()) {
+            return;
+        }
+        idleCV.wait(lock, [this] { return requests.empty() && !busy; });
+    }
+
+    /**
+     * @brief Cancels every request that has not started and stops the worker.
+     * The request in progress, if any, is allowed to finish. Cancelled requests
+     * and requests submitted afterwards are reported with ASYNC_REQUEST_CANCELLED.
+     * When called from a completion callback, the worker exits once the
+     * callback returns.
+     */
+    void stop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        std::deque<Request> cancelled;
+        cancelled.swap(requests);
+        std::thread stoppedWorker = std::move(worker);
+        lock.unlock();
+        requestCV.notify_one();
+        idleCV.notify_all();
+        if (stoppedWorker.joinable()) {
+            if (stoppedWorker.get_id() == std::this_thread::get_id()) {
+                stoppedWorker.detach();
+            } else {
+                stoppedWorker.join();
+            }
+        }
+        for (Request& request : cancelled) {
+            if (request.callback != nullptr) {
+                request.callback(request.requestId, ASYNC_REQUEST_CANCELLED);
+            }
+        }
+    }
+
+    ~AsyncSendQueue() {
+        stop();
+        // A worker detached by stop() may still be inside a completion callback.
+        std::unique_lock<std::mutex> lock(mutex);
+        if (workerId != std::this_thread::get_id()) {
+            finishedCV.wait(lock, [this] { return !workerRunning; });
+        }
+    }
+
+private:
+    struct Request {
+        int requestId;
+        ConnectionWrapper* ptr;
+        int (*send)(ConnectionWrapper*, std::string);
+        std::string jsonData;
+        SendCompletionCallback callback;
+    };
+
+    AsyncSendQueue() = default;
+    AsyncSendQueue(const AsyncSendQueue&) = delete;
+    AsyncSendQueue& operator=(const AsyncSendQueue&) = delete;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            requestCV.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) {
+                break;
+            }
+            Request request = std::move(requests.front());
+            requests.pop_front();
+            busy = true;
+            lock.unlock();
+
+            int status = request.send(request.ptr, std::move(request.jsonData));
+            if (request.callback != nullptr) {
+                request.callback(request.requestId, status);
+            }
+
+            lock.lock();
+            busy = false;
+            if (requests.empty()) {
+                idleCV.notify_all();
+            }
+        }
+        workerRunning = false;
+        finishedCV.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable requestCV;
+    std::condition_variable idleCV;
+    std::condition_variable finishedCV;
+    std::deque<Request> requests;
+    std::thread worker;
+    std::thread::id workerId;
+    int lastRequestId = 0;
+    bool busy = false;
+    bool workerRunning = false;
+    bool stopping = false;
+};
+
+/**
+ * @brief Queues a basket for the fiscal device and returns without waiting.
+ * @param ptr A pointer to the ConnectionWrapper object.
+ * @param jsonData A JSON string representing the basket data.
+ * @param callback The function to be called with the status code of sendBasket().
+ * @return The request id that will be passed to the callback.
+ */
+inline int sendBasketAsync(ConnectionWrapper* ptr, std::string jsonData, SendCompletionCallback callback) {
+    return AsyncSendQueue::instance().submit(ptr, &sendBasket, std::move(jsonData), callback);
+}
+
+/**
+ * @brief Queues payment information for the fiscal device and returns without waiting.
+ * @param ptr A pointer to the ConnectionWrapper object.
+ * @param jsonData A JSON string representing the payment data.
+ * @param callback The function to be called with the status code of sendPayment().
+ * @return The request id that will be passed to the callback.
+ */
+inline int sendPaymentAsync(ConnectionWrapper* ptr, std::string jsonData, SendCompletionCallback callback) {
+    return AsyncSendQueue::instance().submit(ptr, &sendPayment, std::move(jsonData), callback);
+}
+
+/**
+ * @brief Blocks until all queued basket and payment requests have completed.
+ * Call this before any blocking sendBasket(), sendPayment() or getFiscalInfo()
+ * call; otherwise both would run inside the library at the same time.
+ */
+inline void waitAsyncRequests() {
+    AsyncSendQueue::instance().wait();
+}
+
+/**
+ * @brief Cancels all queued basket and payment requests that have not started.
+ * Each cancelled request is reported with ASYNC_REQUEST_CANCELLED; requests
+ * queued afterwards are cancelled immediately. Call this when shutting down,
+ * before deleteCommunication(), so nothing is sent while the process exits.
+ */
+inline void stopAsyncRequests() {
+    AsyncSendQueue::instance().stop();
+}
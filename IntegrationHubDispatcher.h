@@ -0,0 +1,318 @@
+/**
+ * @file IntegrationHubDispatcher.h
+ * @brief Runs SerialInCallback and DeviceStateCallback off the library's I/O thread.
+ *
+ * Forwarding callbacks registered with the library only push each event into
+ * a bounded queue; a dedicated worker thread calls the application's handlers
+ * in arrival order, so a slow handler no longer delays inbound frames.
+ */
+
+#pragma once
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "IntegrationHubWrapper.h"
+
+/**
+ * @brief What to do with a serial frame that arrives while the queue is full.
+ * The capacity only counts serial frames. Device state changes are rare, are
+ * always queued regardless of the policy, and never take a frame's place.
+ */
+enum DispatchOverflowPolicy {
+    DISPATCH_BLOCK = 0,       ///< Wait for free space. Nothing is lost, but the I/O thread may stall.
+    DISPATCH_DROP_NEWEST = 1, ///< Discard the frame that just arrived.
+    DISPATCH_DROP_OLDEST = 2  ///< Discard the oldest queued frame to make room.
+};
+
+/**
+ * @brief Snapshot of the dispatcher counters.
+ * Callback times are measured with a monotonic clock, in microseconds.
+ */
+struct CallbackDispatcherStats {
+    size_t queueDepth;            ///< Serial frames waiting to be delivered right now.
+    size_t maxQueueDepth;         ///< Highest serial frame queue depth seen so far.
+    size_t deviceStateQueueDepth; ///< Device state changes waiting to be delivered right now.
+    uint64_t delivered;           ///< Events handed to the application's callbacks.
+    uint64_t dropped;             ///< Events discarded by the overflow policy or by stopCallbackDispatcher().
+    uint64_t blocked;             ///< Times the I/O thread had to wait under DISPATCH_BLOCK.
+    uint64_t totalCallbackTimeUs; ///< Sum of time spent inside the application's callbacks.
+    uint64_t maxCallbackTimeUs;   ///< Longest single callback execution.
+};
+
+/**
+ * @brief Bounded event queue with one worker thread that runs the user callbacks.
+ * The library's callbacks carry no user pointer, so there is one dispatcher
+ * per process; its worker is started by the first registered callback.
+ */
+class CallbackDispatcher {
+public:
+    /**
+     * @brief Returns the process-wide dispatcher instance.
+     */
+    static CallbackDispatcher& instance() {
+        static CallbackDispatcher dispatcher;
+        return dispatcher;
+    }
+
+    /**
+     * @brief Changes the queue capacity and overflow policy.
+     * @param newCapacity Maximum number of queued serial frames (values below 1 are treated as 1).
+     * @param newPolicy What to do with serial frames when the queue is full.
+     */
+    void configure(size_t newCapacity, DispatchOverflowPolicy newPolicy) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            capacity = newCapacity > 0 ? newCapacity : 1;
+            policy = newPolicy;
+        }
+        spaceCV.notify_all();
+    }
+
+    void setSerialInCallback(SerialInCallback callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        serialInCallback = callback;
+        startWorker();
+    }
+
+    void setDeviceStateCallback(DeviceStateCallback callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deviceStateCallback = callback;
+        startWorker();
+    }
+
+    CallbackDispatcherStats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        CallbackDispatcherStats snapshot = stats;
+        snapshot.queueDepth = queuedFrames;
+        snapshot.deviceStateQueueDepth = events.size() - queuedFrames;
+        return snapshot;
+    }
+
+    /**
+     * @brief Forwarding SerialInCallback registered with the library.
+     */
+    static void onSerialIn(int tag, std::string data) {
+        instance().post(false, tag, false, std::move(data));
+    }
+
+    /**
+     * @brief Forwarding DeviceStateCallback registered with the library.
+     */
+    static void onDeviceState(bool state, std::string deviceId) {
+        instance().post(true, 0, state, std::move(deviceId));
+    }
+
+    /**
+     * @brief Stops the worker thread and discards events that were not delivered.
+     * Events posted after this call are counted as dropped. A callback that is
+     * already running is allowed to finish first, unless stop() is called from
+     * that callback, in which case the worker exits once the callback returns.
+     */
+    void stop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        stats.dropped += events.size();
+        events.clear();
+        queuedFrames = 0;
+        std::thread stoppedWorker = std::move(worker);
+        lock.unlock();
+        eventCV.notify_one();
+        spaceCV.notify_all();
+        if (stoppedWorker.joinable()) {
+            if (stoppedWorker.get_id() == std::this_thread::get_id()) {
+                stoppedWorker.detach();
+            } else {
+                stoppedWorker.join();
+            }
+        }
+    }
+
+    ~CallbackDispatcher() {
+        stop();
+        // A worker detached by stop() may still be inside a user callback.
+        std::unique_lock<std::mutex> lock(mutex);
+        if (workerId != std::this_thread::get_id()) {
+            finishedCV.wait(lock, [this] { return !workerRunning; });
+        }
+    }
+
+private:
+    struct Event {
+        bool isDeviceState;
+        int tag;
+        bool state;
+        std::string data;
+    };
+
+    CallbackDispatcher() : stats() {}
+    CallbackDispatcher(const CallbackDispatcher&) = delete;
+    CallbackDispatcher& operator=(const CallbackDispatcher&) = delete;
+
+    // Must be called with the mutex held.
+    void startWorker() {
+        if (!stopping && !workerRunning) {
+            workerRunning = true;
+            worker = std::thread(&CallbackDispatcher::run, this);
+            workerId = worker.get_id();
+        }
+    }
+
+    void post(bool isDeviceState, int tag, bool state, std::string&& data) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping) {
+            ++stats.dropped;
+            return;
+        }
+        if (!isDeviceState && queuedFrames >= capacity) {
+            if (policy == DISPATCH_DROP_NEWEST) {
+                ++stats.dropped;
+                return;
+            }
+            if (policy == DISPATCH_DROP_OLDEST) {
+                dropOldestFrame();
+            } else {
+                ++stats.blocked;
+                spaceCV.wait(lock, [this] { return stopping || queuedFrames < capacity; });
+                if (stopping) {
+                    ++stats.dropped;
+                    return;
+                }
+            }
+        }
+        events.emplace_back();
+        Event& event = events.back();
+        event.isDeviceState = isDeviceState;
+        event.tag = tag;
+        event.state = state;
+        event.data = std::move(data);
+        if (!isDeviceState) {
+            ++queuedFrames;
+            if (queuedFrames > stats.maxQueueDepth) {
+                stats.maxQueueDepth = queuedFrames;
+            }
+        }
+        lock.unlock();
+        eventCV.notify_one();
+    }
+
+    // Must be called with the mutex held and at least one frame queued.
+    // Device state events are kept.
+    void dropOldestFrame() {
+        for (std::deque<Event>::iterator it = events.begin(); it != events.end(); ++it) {
+            if (!it->isDeviceState) {
+                events.erase(it);
+                --queuedFrames;
+                ++stats.dropped;
+                return;
+            }
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            eventCV.wait(lock, [this] { return stopping || !events.empty(); });
+            if (stopping) {
+                break;
+            }
+            Event event = std::move(events.front());
+            events.pop_front();
+            if (!event.isDeviceState) {
+                --queuedFrames;
+            }
+            SerialInCallback serialIn = serialInCallback;
+            DeviceStateCallback deviceState = deviceStateCallback;
+            lock.unlock();
+            spaceCV.notify_one();
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if (event.isDeviceState) {
+                if (deviceState != nullptr) {
+                    deviceState(event.state, std::move(event.data));
+                }
+            } else if (serialIn != nullptr) {
+                serialIn(event.tag, std::move(event.data));
+            }
+            uint64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            lock.lock();
+            ++stats.delivered;
+            stats.totalCallbackTimeUs += elapsedUs;
+            if (elapsedUs > stats.maxCallbackTimeUs) {
+                stats.maxCallbackTimeUs = elapsedUs;
+            }
+        }
+        workerRunning = false;
+        finishedCV.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable eventCV;
+    std::condition_variable spaceCV;
+    std::condition_variable finishedCV;
+    std::deque<Event> events;
+    std::thread worker;
+    std::thread::id workerId;
+    size_t capacity = 1024;
+    size_t queuedFrames = 0;
+    DispatchOverflowPolicy policy = DISPATCH_BLOCK;
+    SerialInCallback serialInCallback = nullptr;
+    DeviceStateCallback deviceStateCallback = nullptr;
+    CallbackDispatcherStats stats;
+    bool workerRunning = false;
+    bool stopping = false;
+};
+
+/**
+ * @brief Configures the callback queue shared by all dispatched callbacks.
+ * The default is a capacity of 1024 serial frames with DISPATCH_BLOCK.
+ * @param capacity Maximum number of serial frames waiting for the worker thread.
+ * @param policy What to do with serial frames when the queue is full.
+ */
+inline void configureCallbackDispatcher(size_t capacity, DispatchOverflowPolicy policy) {
+    CallbackDispatcher::instance().configure(capacity, policy);
+}
+
+/**
+ * @brief Same as setSerialInCallback(), but the callback runs on the dispatcher thread.
+ * @param ptr A pointer to the ConnectionWrapper object.
+ * @param callback The function to be called when serial data is received.
+ */
+inline void setDispatchedSerialInCallback(ConnectionWrapper* ptr, SerialInCallback callback) {
+    CallbackDispatcher::instance().setSerialInCallback(callback);
+    setSerialInCallback(ptr, &CallbackDispatcher::onSerialIn);
+}
+
+/**
+ * @brief Same as setDeviceStateCallback(), but the callback runs on the dispatcher thread.
+ * @param ptr A pointer to the ConnectionWrapper object.
+ * @param callback The function to be called when the device state changes.
+ */
+inline void setDispatchedDeviceStateCallback(ConnectionWrapper* ptr, DeviceStateCallback callback) {
+    CallbackDispatcher::instance().setDeviceStateCallback(callback);
+    setDeviceStateCallback(ptr, &CallbackDispatcher::onDeviceState);
+}
+
+/**
+ * @brief Stops the dispatcher thread and discards undelivered events.
+ * Call this after deleteCommunication(), once the library no longer calls the
+ * forwarding callbacks, so shutdown does not depend on static destruction.
+ * Callbacks registered afterwards are not delivered.
+ */
+inline void stopCallbackDispatcher() {
+    CallbackDispatcher::instance().stop();
+}
+
+/**
+ * @brief Returns the current queue depth, drop counts and callback timings.
+ * @return A snapshot of the dispatcher counters.
+ */
+inline CallbackDispatcherStats getCallbackDispatcherStats() {
+    return CallbackDispatcher::instance().getStats();
+}
@@ -12,6 +12,8 @@
 #include <iostream>
 #include <vector>
 #include "IntegrationHubWrapper.h"
+#include "IntegrationHubAsync.h"
+#include "IntegrationHubDispatcher.h"
 
 // these 2 are just to keep app alive
 #include <chrono>
@@ -20,7 +22,7 @@
 
 /**
  * @brief Callback function to handle serial data received from the IntegrationHub.
- * This function is registered with the library and called asynchronously.
+ * This function is registered through the callback dispatcher and runs on its worker thread.
  * @param tag An integer tag identifying the data source.
  * @param data The serial data received.
  */
@@ -30,7 +32,7 @@ void setSerialInCallbackTest(int tag, std::string data) {
 
 /**
  * @brief Callback function to handle device state changes.
- * This function is registered with the library and called when a device is connected or disconnected.
+ * This function is registered through the callback dispatcher and called when a device is connected or disconnected.
  * @param state The new state of the device (true for connected, false for disconnected).
  * @param deviceId A string identifying the device.
  */
@@ -38,6 +40,16 @@ void setDeviceStateCallbackTest(bool state, std::string deviceId) {
     std::cout << "Device State Callback Result In Test: \n" << deviceId << std::endl;
 }
 
+/**
+ * @brief Callback function to handle the result of an asynchronous send.
+ * This function is called on the background sender thread.
+ * @param requestId The id returned when the request was queued.
+ * @param status The status code of the completed request.
+ */
+void sendCompletionCallbackTest(int requestId, int status) {
+    std::cout << "Send Completion Callback Result In Test: request " << requestId << " status " << status << std::endl;
+}
+
 
 /**
  * @brief Sends a sample basket to the active fiscal device.
@@ -55,6 +67,22 @@ void sendBasketTest(ConnectionWrapper* communication, int activeDevice) {
     }
 }
 
+/**
+ * @brief Queues a sample basket for the active fiscal device without blocking.
+ * The result is reported later through sendCompletionCallbackTest.
+ * @param communication A pointer to the ConnectionWrapper object.
+ * @param activeDevice The index of the active device (0 for X30TR, 1 for 300TR).
+ */
+void sendBasketAsyncTest(ConnectionWrapper* communication, int activeDevice) {
+    if (activeDevice == 0) { // X30TR
+        int requestId = sendBasketAsync(communication, "{\n  \"basketID\": \"a123ca24-ca2c-401c-8134-f0de2ec25c25\",\n  \"documentType\": 9008,\n  \"customerInfo\": {\n    \"taxID\": \"11111111111\"\n  },\n  \"items\": [\n    {\n      \"name\": \"�LA�\",\n      \"price\": 1000,\n      \"quantity\": 1000,\n      \"sectionNo\": 2,\n      \"taxPercent\": 2000,\n      \"type\": 0\n    }\n  ],\n  \"taxFreeAmount\": 5000,\n  \"paymentItems\": [\n    {\n      \"amount\": 6000,\n      \"description\": \"Cash\",\n      \"type\": 1\n    }\n  ]\n}", sendCompletionCallbackTest);
+        std::cout << "basketRequestId: " << requestId << std::endl;
+    } else if (activeDevice == 1) { // 300TR
+        int requestId = sendBasketAsync(communication, "{\n  \"basketID\": \"a123ca24-ca2c-401c-8134-f0de2ec25c25\",\n  \"documentType\": 0,\n  \"customerInfo\": {\n    \"taxID\": \"11111111111\"\n  },\n  \"items\": [\n    {\n      \"name\": \"�LA�\",\n      \"price\": 1000,\n      \"quantity\": 1000,\n      \"sectionNo\": 1,\n      \"taxPercent\": 1000,\n      \"type\": 0\n    }\n  ],\n  \"taxFreeAmount\": 5000\n}", sendCompletionCallbackTest);
+        std::cout << "basketRequestId: " << requestId << std::endl;
+    }
+}
+
 /**
  * @brief Sends a sample payment to the 300TR device.
  * This function is specific to the 300TR model.
@@ -77,6 +105,18 @@ void getFiscalInfoTest(ConnectionWrapper* communication) {
     std::cout << "Get Fiscal Info Result In Test: \n" << fiscalInfo << std::endl;
 }
 
+/**
+ * @brief Prints the callback dispatcher counters.
+ */
+void getCallbackDispatcherStatsTest() {
+    CallbackDispatcherStats stats = getCallbackDispatcherStats();
+    std::cout << "Callback Dispatcher Stats In Test:" << std::endl;
+    std::cout << "queueDepth: " << stats.queueDepth << " maxQueueDepth: " << stats.maxQueueDepth << std::endl;
+    std::cout << "deviceStateQueueDepth: " << stats.deviceStateQueueDepth << std::endl;
+    std::cout << "delivered: " << stats.delivered << " dropped: " << stats.dropped << " blocked: " << stats.blocked << std::endl;
+    std::cout << "totalCallbackTimeUs: " << stats.totalCallbackTimeUs << " maxCallbackTimeUs: " << stats.maxCallbackTimeUs << std::endl;
+}
+
 
 /**
  * @brief Main handler for the test application logic.
@@ -86,20 +126,26 @@ void getFiscalInfoTest(ConnectionWrapper* communication) {
 void threadHandle() {
     const std::string companyName = "TokenLinuxTest";
     ConnectionWrapper* communication = createCommunication(companyName);
-    setSerialInCallback(communication, setSerialInCallbackTest);
-    setDeviceStateCallback(communication, setDeviceStateCallbackTest);
+    setDispatchedSerialInCallback(communication, setSerialInCallbackTest);
+    setDispatchedDeviceStateCallback(communication, setDeviceStateCallbackTest);
 
     std::this_thread::sleep_for(std::chrono::seconds(3));
 
     while (true) {
-        std::cout << "Press [0-3] to execute the actions below" << std::endl;
+        std::cout << "Press [0-5] to execute the actions below" << std::endl;
         std::cout << "0: Get Active Device" << std::endl;
         std::cout << "1: Send Example Basket" << std::endl;
         std::cout << "2: Send Example Payment" << std::endl;
         std::cout << "3: Get Fiscal Info" << std::endl;
+        std::cout << "4: Send Example Basket (Async)" << std::endl;
+        std::cout << "5: Get Callback Dispatcher Stats" << std::endl;
 
         int input;
         std::cin >> input;
+        if (input >= 1 && input <= 3) {
+            // blocking actions must not overlap with queued async requests
+            waitAsyncRequests();
+        }
         int activeDevice = getActiveDeviceIndex(communication);
         switch (input)
         {
@@ -115,6 +161,12 @@ void threadHandle() {
             case 3: // Get Fiscal Info
                 getFiscalInfoTest(communication);
                 break;
+            case 4: // Send Example Basket (Async)
+                sendBasketAsyncTest(communication, activeDevice);
+                break;
+            case 5: // Get Callback Dispatcher Stats
+                getCallbackDispatcherStatsTest();
+                break;
             default:
                 break;
         }